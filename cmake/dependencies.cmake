@@ -15,6 +15,7 @@ FetchContent_Declare(
 FetchContent_MakeAvailable(fixed_string_lib fmt_lib)
 
 find_package(Boost 1.81 REQUIRED)
+find_package(Threads REQUIRED)
 
 if (DSVIEW_BUILD_TESTS)
 
@@ -9,5 +9,8 @@
 
 #pragma once
 
+#include "dslib/acquisition.hpp"
 #include "dslib/device.hpp"
-#include "dslib/scpi.hpp"
\ No newline at end of file
+#include "dslib/scpi.hpp"
+#include "dslib/socket_device.hpp"
+#include "dslib/transport.hpp"
\ No newline at end of file
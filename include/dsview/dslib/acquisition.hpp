@@ -0,0 +1,66 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "device.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ds
+{
+
+// Selects the source and switches the waveform readout to RAW/BYTE, so that whole acquisition memory can be fetched
+void setup_waveform( idevice& device, std::string_view channel );
+
+// Reads points [1, points] of the current :WAV:SOUR into dst in as many :WAV:DATA? blocks as needed. Returns the number
+// of bytes received.
+auto read_waveform(
+    idevice& device,
+    idevice::mutable_buffer_view dst,
+    std::size_t points,
+    idevice::timeout_type timeout ) -> std::size_t;
+
+// Fetches several channels at once over one connection per channel. Each connection keeps its own :WAV:SOUR for its
+// whole lifetime, and the instrument prepares the next block on one session while another one is being transferred.
+class parallel_channel_fetcher
+{
+  public:
+    using device_factory = std::function<std::unique_ptr<idevice>()>;
+
+    parallel_channel_fetcher( const device_factory& factory, std::vector<std::string> channels, std::size_t points );
+
+    void fetch( idevice::timeout_type timeout = idevice::default_timeout );
+
+    [[nodiscard]] auto size() const -> std::size_t { return m_sessions.size(); }
+    [[nodiscard]] auto channel( std::size_t index ) const -> std::string_view { return m_sessions.at( index ).channel; }
+    [[nodiscard]] auto data( std::size_t index ) const -> idevice::buffer_view;
+    [[nodiscard]] auto bytes_received() const -> std::size_t;
+
+  private:
+    struct channel_session
+    {
+        std::string channel;
+        std::unique_ptr<idevice> device;
+        idevice::buffer_type buffer; //< Preallocated for the whole memory depth and reused between fetches
+        std::size_t size = 0;
+    };
+
+  private:
+    std::vector<channel_session> m_sessions;
+    std::size_t m_points;
+};
+
+} // namespace ds
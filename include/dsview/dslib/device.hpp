@@ -21,6 +21,7 @@
 #include <iostream>
 #include <optional>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 namespace ds
@@ -32,10 +33,15 @@ struct block_query_t
 
 static constexpr auto block_query = block_query_t{};
 
+// Commands whose query parser marks itself with is_block answer with an IEEE 488.2 definite length block
+template <typename command_t>
+concept binary_block_command = requires { requires command_t::query_parser::is_block; };
+
 class idevice
 {
   public:
     using buffer_view = std::span<const char>;
+    using mutable_buffer_view = std::span<char>;
     using buffer_type = std::vector<char>;
     using timeout_type = std::chrono::milliseconds;
 
@@ -49,11 +55,14 @@ class idevice
     [[nodiscard]] virtual auto read_n( as_string_t, std::size_t n, timeout_type ) -> std::string = 0;
     [[nodiscard]] virtual auto read_n( as_vector_t, std::size_t n, timeout_type ) -> buffer_type = 0;
 
+    // Fills the whole of dst or throws. Lets bulk transfers land directly in a caller-owned buffer.
+    virtual void read_into( mutable_buffer_view dst, timeout_type ) = 0;
+
     virtual void write( buffer_view data ) = 0; //< This overload will win for a string literal
 
   public:
     template <typename command_t>
-        requires ( command_t::has_query )
+        requires ( command_t::has_query && !binary_block_command<command_t> )
     auto query( timeout_type time = default_timeout )
     {
         const auto message = fmt::format( "{}\n", std::string_view{ command_t::get_query_string() } );
@@ -64,7 +73,7 @@ class idevice
     }
 
     template <typename command_t>
-        requires ( command_t::has_query )
+        requires ( command_t::has_query && !binary_block_command<command_t> )
     auto query( block_query_t, timeout_type time = default_timeout )
         -> std::optional<std::invoke_result_t<decltype( &command_t::query_parser::parse ), std::string_view>>
     {
@@ -76,6 +85,18 @@ class idevice
         return std::optional{ query<command_t>( time ) };
     }
 
+    // Queries a definite length block (#<N><length><payload>\n) into dst. Returns the payload size. A block larger than
+    // dst is drained before std::length_error is thrown, so the device stays usable for further queries.
+    template <binary_block_command command_t>
+    auto query_block( mutable_buffer_view dst, timeout_type time = default_timeout ) -> std::size_t
+    {
+        const auto message = fmt::format( "{}\n", std::string_view{ command_t::get_query_string() } );
+        write( message );
+        return read_block( dst, time );
+    }
+
+    auto read_block( mutable_buffer_view dst, timeout_type time = default_timeout ) -> std::size_t;
+
     template <typename command_t, typename... args_t>
         requires ( command_t::has_operation )
     void submit( args_t&&... args )
@@ -89,6 +110,13 @@ class idevice
     virtual ~idevice() = default;
 };
 
+// Socket tuning shared by every LAN transport, so that backends differ only in how they move bytes
+struct socket_options
+{
+    int receive_buffer_size = 4 * 1024 * 1024; //< SO_RCVBUF hint, 0 keeps the kernel default
+    bool no_delay = true;                      //< TCP_NODELAY, short queries should not wait for Nagle
+};
+
 class lan_device : public idevice
 {
   public:
@@ -98,17 +126,23 @@ class lan_device : public idevice
     [[nodiscard]] auto read_n( as_string_t, std::size_t n, timeout_type = default_timeout ) -> std::string override;
     [[nodiscard]] auto read_n( as_vector_t, std::size_t n, timeout_type = default_timeout ) -> buffer_type override;
 
+    void read_into( mutable_buffer_view dst, timeout_type = default_timeout ) override;
+
     void write( buffer_view data ) override;
 
   public:
     static constexpr auto device_port = asio::ip::port_type{ 5555 };
-    lan_device( std::string_view host, std::string_view port = std::to_string( device_port ) );
+    lan_device(
+        std::string_view host,
+        std::string_view port = std::to_string( device_port ),
+        socket_options options = {} );
     [[nodiscard]] auto endpoint() const -> tcp::endpoint { return m_endpoint; }
 
   private:
     auto resolve( std::string_view host, std::string_view port ) -> tcp::endpoint;
 
     template <typename result_t> auto read_impl( timeout_type timeout, auto async_func ) -> result_t;
+    void run_impl( timeout_type timeout, auto async_func, auto on_complete );
 
   private:
     boost::asio::io_service m_service;
@@ -120,6 +154,26 @@ class lan_device : public idevice
 template <typename result_t>
 auto
 lan_device::read_impl( timeout_type timeout, auto async_func ) -> result_t
+{
+    result_t res;
+    run_impl(
+        timeout,
+        [ this, &async_func ]( auto&& handler ) { async_func( m_sock, m_streambuf, handler ); },
+        [ this, &res ]( std::size_t num_transferred ) {
+            res.reserve( num_transferred );
+            std::copy(
+                std::istreambuf_iterator<char>{ &m_streambuf },
+                std::istreambuf_iterator<char>{},
+                std::back_inserter( res ) );
+
+            assert( m_streambuf.size() == 0 && "Buffer should have been emptied" );
+        } );
+
+    return res;
+}
+
+void
+lan_device::run_impl( timeout_type timeout, auto async_func, auto on_complete )
 {
     auto timer_handler = [ &sock = m_sock ]( boost::system::error_code code ) {
         if ( code == asio::error::operation_aborted )
@@ -134,7 +188,7 @@ lan_device::read_impl( timeout_type timeout, auto async_func ) -> result_t
             throw boost::system::system_error{ code };
         }
 
-        throw std::runtime_error{ "Timeout on read operation: lan_device::read_impl" };
+        throw std::runtime_error{ "Timeout on read operation: lan_device::run_impl" };
     };
 
     auto timer = asio::steady_timer{ m_service, std::chrono::steady_clock::now() + timeout };
@@ -143,8 +197,7 @@ lan_device::read_impl( timeout_type timeout, auto async_func ) -> result_t
         timer.async_wait( timer_handler );
     }
 
-    result_t res;
-    auto read_handler = [ this, &res, &timer ]( boost::system::error_code code, std::size_t num_transferred ) {
+    auto read_handler = [ &on_complete, &timer ]( boost::system::error_code code, std::size_t num_transferred ) {
         if ( code == asio::error::operation_aborted )
         {
             return;
@@ -157,20 +210,12 @@ lan_device::read_impl( timeout_type timeout, auto async_func ) -> result_t
             throw boost::system::system_error{ code };
         }
 
-        res.reserve( num_transferred );
-        std::copy(
-            std::istreambuf_iterator<char>{ &m_streambuf },
-            std::istreambuf_iterator<char>{},
-            std::back_inserter( res ) );
-
-        assert( m_streambuf.size() == 0 && "Buffer should have been emptied" );
+        on_complete( num_transferred );
     };
 
-    async_func( m_sock, m_streambuf, read_handler );
+    async_func( read_handler );
     m_service.restart();
     m_service.run();
-
-    return res;
 }
 
 } // namespace ds
\ No newline at end of file
@@ -10,4 +10,4 @@
 #pragma once
 
 #include "scpi/command.hpp"
-#include "scpi/commands/common.hpp"
+#include "scpi/commands/all.hpp"
@@ -9,4 +9,7 @@
 
 #pragma once
 
-#include "common.hpp"
\ No newline at end of file
+#include "common.hpp"
+#include "root.hpp"
+#include "trigger.hpp"
+#include "waveform.hpp"
\ No newline at end of file
@@ -0,0 +1,21 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "dsview/dslib/scpi/command.hpp"
+
+namespace ds::scpi::root
+{
+
+using run_cmd = basic_command<root_category, fixstr::fixed_string{ ":RUN" }, void, std::tuple<>>;
+using stop_cmd = basic_command<root_category, fixstr::fixed_string{ ":STOP" }, void, std::tuple<>>;
+using single_cmd = basic_command<root_category, fixstr::fixed_string{ ":SING" }, void, std::tuple<>>;
+
+} // namespace ds::scpi::root
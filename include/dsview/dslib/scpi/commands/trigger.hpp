@@ -0,0 +1,90 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <boost/spirit/home/x3.hpp>
+
+#include "dsview/dslib/scpi/command.hpp"
+
+#include <stdexcept>
+#include <string_view>
+
+namespace ds::scpi::trigger
+{
+
+enum class trigger_status
+{
+    e_td,
+    e_wait,
+    e_run,
+    e_auto,
+    e_stop
+};
+
+[[nodiscard]] constexpr auto
+to_string( trigger_status status ) -> std::string_view
+{
+    switch ( status )
+    {
+    case trigger_status::e_td:
+        return "TD";
+    case trigger_status::e_wait:
+        return "WAIT";
+    case trigger_status::e_run:
+        return "RUN";
+    case trigger_status::e_auto:
+        return "AUTO";
+    case trigger_status::e_stop:
+        return "STOP";
+    }
+
+    throw std::out_of_range{ "Trigger status is unknown" };
+}
+
+namespace x3 = boost::spirit::x3;
+
+namespace parser
+{
+
+struct status_query_parser
+{
+    struct status_table : x3::symbols<trigger_status>
+    {
+        status_table()
+        {
+            for ( auto status : { trigger_status::e_td,
+                                  trigger_status::e_wait,
+                                  trigger_status::e_run,
+                                  trigger_status::e_auto,
+                                  trigger_status::e_stop } )
+            {
+                add( to_string( status ), status );
+            }
+        }
+    };
+
+    [[nodiscard]] static auto parse( std::string_view str ) -> trigger_status
+    {
+        static const status_table status_parser;
+        static const auto parser = x3::expect[ status_parser >> '\n' ];
+
+        auto result = trigger_status{};
+        x3::parse( begin( str ), end( str ), parser, result );
+        return result;
+    }
+};
+
+} // namespace parser
+
+using trigger_category = basic_category<root_category, fixstr::fixed_string{ ":TRIG" }>;
+
+using status_cmd = basic_command<trigger_category, fixstr::fixed_string{ "STAT" }, parser::status_query_parser, void>;
+
+} // namespace ds::scpi::trigger
@@ -0,0 +1,67 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <boost/spirit/home/x3.hpp>
+
+#include "dsview/dslib/scpi/command.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace ds::scpi::waveform
+{
+
+namespace x3 = boost::spirit::x3;
+
+namespace parser
+{
+
+// Marks commands that answer with an IEEE 488.2 definite length block, see idevice::query_block
+struct block_query_parser
+{
+    static constexpr bool is_block = true;
+    static constexpr auto max_points_per_read = std::size_t{ 250'000 }; //< Limit for BYTE format in RAW mode
+};
+
+struct memory_depth_query_parser
+{
+    [[nodiscard]] static auto parse( std::string_view str ) -> std::optional<std::size_t>
+    {
+        if ( str.starts_with( "AUTO" ) )
+        {
+            return std::nullopt;
+        }
+
+        // Depth is reported either as an integer or in scientific notation, e.g. 1.2E+06
+        static const auto parser = x3::expect[ x3::double_ >> '\n' ];
+        auto result = double{};
+        x3::parse( begin( str ), end( str ), parser, result );
+        return static_cast<std::size_t>( result );
+    }
+};
+
+} // namespace parser
+
+using waveform_category = basic_category<root_category, fixstr::fixed_string{ ":WAV" }>;
+using acquire_category = basic_category<root_category, fixstr::fixed_string{ ":ACQ" }>;
+
+using source_cmd = basic_command<waveform_category, fixstr::fixed_string{ "SOUR" }, void, std::tuple<std::string_view>>;
+using mode_cmd = basic_command<waveform_category, fixstr::fixed_string{ "MODE" }, void, std::tuple<std::string_view>>;
+using format_cmd = basic_command<waveform_category, fixstr::fixed_string{ "FORM" }, void, std::tuple<std::string_view>>;
+using start_cmd = basic_command<waveform_category, fixstr::fixed_string{ "STAR" }, void, std::tuple<std::size_t>>;
+using stop_cmd = basic_command<waveform_category, fixstr::fixed_string{ "STOP" }, void, std::tuple<std::size_t>>;
+using data_cmd = basic_command<waveform_category, fixstr::fixed_string{ "DATA" }, parser::block_query_parser, void>;
+
+using memory_depth_cmd =
+    basic_command<acquire_category, fixstr::fixed_string{ "MDEP" }, parser::memory_depth_query_parser, void>;
+
+} // namespace ds::scpi::waveform
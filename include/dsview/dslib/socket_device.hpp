@@ -0,0 +1,72 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "device.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ds
+{
+
+// Thin transport over a blocking POSIX socket. Bulk reads go straight from the kernel into the caller's buffer with
+// MSG_WAITALL, without an intermediate streambuf and without spinning an io_service per call.
+class socket_device : public idevice
+{
+  public:
+    [[nodiscard]] auto read_until( as_vector_t, timeout_type, std::string_view delim ) -> buffer_type override;
+    [[nodiscard]] auto read_until( as_string_t, timeout_type, std::string_view delim ) -> std::string override;
+
+    [[nodiscard]] auto read_n( as_string_t, std::size_t n, timeout_type = default_timeout ) -> std::string override;
+    [[nodiscard]] auto read_n( as_vector_t, std::size_t n, timeout_type = default_timeout ) -> buffer_type override;
+
+    void read_into( mutable_buffer_view dst, timeout_type = default_timeout ) override;
+
+    void write( buffer_view data ) override;
+
+  public:
+    socket_device(
+        std::string_view host,
+        std::string_view port = std::to_string( lan_device::device_port ),
+        socket_options options = {} );
+
+    socket_device( const socket_device& ) = delete;
+    auto operator=( const socket_device& ) -> socket_device& = delete;
+
+    ~socket_device() override;
+
+    [[nodiscard]] auto native_handle() const -> int { return m_fd; }
+
+  private:
+    using clock_type = std::chrono::steady_clock;
+    using deadline_type = std::optional<clock_type::time_point>;
+
+    [[nodiscard]] static auto make_deadline( timeout_type timeout ) -> deadline_type;
+
+    template <typename result_t> auto read_until_impl( timeout_type timeout, std::string_view delim ) -> result_t;
+    template <typename result_t> auto read_n_impl( std::size_t n, timeout_type timeout ) -> result_t;
+
+    auto consume_pending( mutable_buffer_view dst ) -> std::size_t;
+    auto recv_some( mutable_buffer_view dst, int flags, deadline_type deadline ) -> std::size_t;
+    void set_receive_timeout( timeout_type timeout );
+
+  private:
+    static constexpr auto chunk_size = std::size_t{ 4096 };
+
+    int m_fd = -1;
+    buffer_type m_pending; //< Bytes received past the last delimiter
+    std::optional<timeout_type> m_receive_timeout; //< Last SO_RCVTIMEO value applied to the socket
+};
+
+} // namespace ds
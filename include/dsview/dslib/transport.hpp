@@ -0,0 +1,79 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "device.hpp"
+#include "socket_device.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace ds
+{
+
+enum class transport_kind
+{
+    e_asio,
+    e_posix
+};
+
+[[nodiscard]] constexpr auto
+to_string( transport_kind kind ) -> std::string_view
+{
+    switch ( kind )
+    {
+    case transport_kind::e_asio:
+        return "asio";
+    case transport_kind::e_posix:
+        return "posix";
+    }
+
+    throw std::out_of_range{ "Transport kind is unknown" };
+}
+
+[[nodiscard]] constexpr auto
+to_transport( std::string_view name ) -> transport_kind
+{
+    if ( name == "asio" )
+    {
+        return transport_kind::e_asio;
+    }
+
+    if ( name == "posix" )
+    {
+        return transport_kind::e_posix;
+    }
+
+    throw std::out_of_range{ "Transport name is unknown" };
+}
+
+// Both backends expose the same idevice interface, take the same socket_options and treat a timeout as a deadline for
+// the whole read call, so callers can swap them to compare throughput and latency.
+[[nodiscard]] inline auto
+make_lan_device(
+    transport_kind kind,
+    std::string_view host,
+    std::string_view port = std::to_string( lan_device::device_port ),
+    socket_options options = {} ) -> std::unique_ptr<idevice>
+{
+    switch ( kind )
+    {
+    case transport_kind::e_asio:
+        return std::make_unique<lan_device>( host, port, options );
+    case transport_kind::e_posix:
+        return std::make_unique<socket_device>( host, port, options );
+    }
+
+    throw std::out_of_range{ "Transport kind is unknown" };
+}
+
+} // namespace ds
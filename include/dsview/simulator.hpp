@@ -0,0 +1,90 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "dslib/detail/common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ds
+{
+
+struct simulator_options
+{
+    std::size_t memory_depth = 1'200'000;
+    std::chrono::microseconds block_delay{ 0 }; //< Time spent preparing each :WAV:DATA? block
+    int arming_polls = 2;                       //< Stale :TRIG:STAT? polls after :SING, unless synced with *OPC?
+};
+
+// Byte the simulator returns for a 1-based waveform point of the given source
+[[nodiscard]] auto simulated_sample( std::string_view source, std::size_t point ) -> char;
+
+// Loopback stand-in for a scope that answers the subset of SCPI used by dsview and the tests. Every accepted
+// connection is served on its own thread with its own :WAV state, like separate LAN sessions on the real instrument.
+class scope_simulator
+{
+  public:
+    explicit scope_simulator( simulator_options options = {} );
+
+    scope_simulator( const scope_simulator& ) = delete;
+    auto operator=( const scope_simulator& ) -> scope_simulator& = delete;
+
+    ~scope_simulator();
+
+    [[nodiscard]] auto host() const -> std::string { return "127.0.0.1"; }
+    [[nodiscard]] auto port() const -> std::string { return std::to_string( m_acceptor.local_endpoint().port() ); }
+    [[nodiscard]] auto single_shots() const -> std::size_t { return m_single_shots; } //< Completed :SING captures
+
+    // Most :WAV:DATA? requests that were being served at the same time, across all sessions
+    [[nodiscard]] auto peak_blocks_in_flight() const -> std::size_t { return m_peak_blocks_in_flight; }
+
+  private:
+    struct session_state
+    {
+        std::string source = "CHAN1";
+        std::size_t start = 1;
+        std::size_t stop = 1200;
+        std::string_view status = "RUN";
+        bool single_pending = false; //< :SING received, but the instrument has not armed yet
+        int stale_polls = 0;         //< Polls left that report the status from before :SING
+        int polls_until_stop = -1;   //< Polls an armed single shot reports WAIT, -1 when not armed
+    };
+
+    void accept_loop();
+    void serve( tcp::socket& sock );
+    [[nodiscard]] auto respond( std::string_view line, session_state& state ) -> std::string;
+    [[nodiscard]] auto trigger_status( session_state& state ) -> std::string_view;
+    [[nodiscard]] auto serve_block( const session_state& state ) -> std::string;
+
+  private:
+    simulator_options m_options;
+    asio::io_service m_service;
+    tcp::acceptor m_acceptor;
+
+    std::atomic<bool> m_stopping = false;
+    std::atomic<std::size_t> m_single_shots = 0;
+    std::atomic<std::size_t> m_blocks_in_flight = 0;
+    std::atomic<std::size_t> m_peak_blocks_in_flight = 0;
+    std::mutex m_sessions_mutex;
+    std::vector<std::shared_ptr<tcp::socket>> m_session_sockets;
+    std::vector<std::jthread> m_sessions;
+
+    std::jthread m_acceptor_thread;
+};
+
+} // namespace ds
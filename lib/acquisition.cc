@@ -0,0 +1,134 @@
+#include "dsview/dslib/acquisition.hpp"
+
+#include "dsview/dslib/scpi/commands/waveform.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+namespace ds
+{
+
+namespace waveform = scpi::waveform;
+
+void
+setup_waveform( idevice& device, std::string_view channel )
+{
+    device.submit<waveform::source_cmd>( std::string_view{ channel } );
+    device.submit<waveform::mode_cmd>( std::string_view{ "RAW" } );
+    device.submit<waveform::format_cmd>( std::string_view{ "BYTE" } );
+}
+
+auto
+read_waveform( idevice& device, idevice::mutable_buffer_view dst, std::size_t points, idevice::timeout_type timeout )
+    -> std::size_t
+{
+    if ( points > dst.size() )
+    {
+        throw std::length_error{ "Waveform does not fit into the destination buffer" };
+    }
+
+    constexpr auto chunk_points = waveform::data_cmd::query_parser::max_points_per_read;
+    auto received = std::size_t{ 0 };
+
+    for ( auto start = std::size_t{ 1 }; start <= points; start += chunk_points )
+    {
+        const auto stop = std::min( start + chunk_points - 1, points );
+        device.submit<waveform::start_cmd>( std::size_t{ start } );
+        device.submit<waveform::stop_cmd>( std::size_t{ stop } );
+
+        // A short block (e.g. points past the memory depth) would shift every following chunk, so it is an error
+        const auto expected = stop - start + 1;
+        const auto size = device.query_block<waveform::data_cmd>( dst.subspan( received, expected ), timeout );
+        if ( size != expected )
+        {
+            throw std::runtime_error{ fmt::format(
+                "Short waveform block: requested points [{}, {}], received {} of {} bytes",
+                start,
+                stop,
+                size,
+                expected ) };
+        }
+
+        received += size;
+    }
+
+    return received;
+}
+
+parallel_channel_fetcher::parallel_channel_fetcher(
+    const device_factory& factory,
+    std::vector<std::string> channels,
+    std::size_t points )
+    : m_points{ points }
+{
+    m_sessions.reserve( channels.size() );
+
+    for ( auto& name : channels )
+    {
+        auto session = channel_session{ std::move( name ), factory(), idevice::buffer_type( points ) };
+        setup_waveform( *session.device, session.channel );
+        m_sessions.push_back( std::move( session ) );
+    }
+}
+
+void
+parallel_channel_fetcher::fetch( idevice::timeout_type timeout )
+{
+    auto pending = std::vector<std::future<std::size_t>>{};
+    pending.reserve( m_sessions.size() );
+
+    for ( auto& session : m_sessions )
+    {
+        session.size = 0;
+        pending.push_back( std::async( std::launch::async, [ &session, points = m_points, timeout ] {
+            return read_waveform( *session.device, session.buffer, points, timeout );
+        } ) );
+    }
+
+    // Wait for every session before rethrowing, so that no task outlives the buffers it writes into
+    auto error = std::exception_ptr{};
+    for ( auto i = std::size_t{ 0 }; i < pending.size(); ++i )
+    {
+        try
+        {
+            m_sessions[ i ].size = pending[ i ].get();
+        } catch ( ... )
+        {
+            if ( !error )
+            {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if ( error )
+    {
+        std::rethrow_exception( error );
+    }
+}
+
+auto
+parallel_channel_fetcher::data( std::size_t index ) const -> idevice::buffer_view
+{
+    const auto& session = m_sessions.at( index );
+    return idevice::buffer_view{ session.buffer }.first( session.size );
+}
+
+auto
+parallel_channel_fetcher::bytes_received() const -> std::size_t
+{
+    auto total = std::size_t{ 0 };
+    for ( const auto& session : m_sessions )
+    {
+        total += session.size;
+    }
+
+    return total;
+}
+
+} // namespace ds
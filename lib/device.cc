@@ -3,7 +3,10 @@
 #include <boost/format.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cctype>
+#include <charconv>
 #include <iterator>
 #include <optional>
 #include <stdexcept>
@@ -13,6 +16,46 @@
 namespace ds
 {
 
+auto
+idevice::read_block( mutable_buffer_view dst, timeout_type timeout ) -> std::size_t
+{
+    const auto prefix = read_n( as_string, 2, timeout );
+    if ( prefix[ 0 ] != '#' || !std::isdigit( static_cast<unsigned char>( prefix[ 1 ] ) ) || prefix[ 1 ] == '0' )
+    {
+        throw std::runtime_error{ str( boost::format( "Malformed block header %s" ) % prefix ) };
+    }
+
+    const auto digits = read_n( as_string, static_cast<std::size_t>( prefix[ 1 ] - '0' ), timeout );
+    auto length = std::size_t{};
+    if ( auto [ ptr, ec ] = std::from_chars( digits.data(), digits.data() + digits.size(), length );
+         ec != std::errc{} || ptr != digits.data() + digits.size() )
+    {
+        throw std::runtime_error{ str( boost::format( "Malformed block length %s" ) % digits ) };
+    }
+
+    if ( length > dst.size() )
+    {
+        // Drain the payload and terminator so that the next query starts on a response boundary
+        auto scratch = std::array<char, 4096>{};
+        for ( auto remaining = length + 1; remaining > 0; )
+        {
+            const auto count = std::min( remaining, scratch.size() );
+            read_into( mutable_buffer_view{ scratch }.first( count ), timeout );
+            remaining -= count;
+        }
+
+        throw std::length_error{ "Block does not fit into the destination buffer" };
+    }
+
+    read_into( dst.first( length ), timeout );
+    if ( const auto terminator = read_n( as_string, 1, timeout ); terminator != "\n" )
+    {
+        throw std::runtime_error{ "Malformed block terminator" };
+    }
+
+    return length;
+}
+
 auto
 lan_device::resolve( std::string_view host, std::string_view port ) -> tcp::endpoint
 {
@@ -27,11 +70,19 @@ lan_device::resolve( std::string_view host, std::string_view port ) -> tcp::endp
     return result.begin()->endpoint();
 }
 
-lan_device::lan_device( std::string_view host, std::string_view port )
+lan_device::lan_device( std::string_view host, std::string_view port, socket_options options )
     : m_endpoint{ resolve( host, port ) },
       m_sock{ m_service }
 {
     m_sock.open( tcp::v4() );
+
+    // Same tuning as socket_device, applied before connect so that the window scale takes the buffer size into account
+    if ( options.receive_buffer_size > 0 )
+    {
+        m_sock.set_option( asio::socket_base::receive_buffer_size{ options.receive_buffer_size } );
+    }
+
+    m_sock.set_option( tcp::no_delay{ options.no_delay } );
     m_sock.connect( m_endpoint );
 }
 
@@ -73,4 +124,16 @@ lan_device::read_n( as_string_t, std::size_t n, timeout_type timeout ) -> std::s
     } );
 }
 
+void
+lan_device::read_into( mutable_buffer_view dst, timeout_type timeout )
+{
+    // Read straight into the caller's memory, bypassing the streambuf
+    run_impl(
+        timeout,
+        [ this, dst ]( auto&& handler ) {
+            asio::async_read( m_sock, asio::buffer( dst ), asio::transfer_exactly( dst.size() ), handler );
+        },
+        []( std::size_t ) {} );
+}
+
 } // namespace ds
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "dsview/simulator.hpp"
+
+#include "dsview/dslib/scpi/commands/waveform.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <istream>
+#include <string>
+
+namespace ds
+{
+
+namespace
+{
+
+constexpr auto max_points_per_read = scpi::waveform::parser::block_query_parser::max_points_per_read;
+
+auto
+parse_number( std::string_view str ) -> std::size_t
+{
+    auto result = std::size_t{};
+    std::from_chars( str.data(), str.data() + str.size(), result );
+    return result;
+}
+
+void
+arm_single( auto& state )
+{
+    state.single_pending = false;
+    state.stale_polls = 0;
+    state.status = "WAIT";
+    state.polls_until_stop = 1;
+}
+
+auto
+make_block( std::string_view source, std::size_t start, std::size_t stop ) -> std::string
+{
+    const auto count = stop < start ? std::size_t{ 0 } : std::min( stop - start + 1, max_points_per_read );
+    auto block = fmt::format( "#9{:09}", count );
+    block.reserve( block.size() + count + 1 );
+    for ( auto i = std::size_t{ 0 }; i < count; ++i )
+    {
+        block.push_back( simulated_sample( source, start + i ) );
+    }
+
+    block.push_back( '\n' );
+    return block;
+}
+
+} // namespace
+
+auto
+simulated_sample( std::string_view source, std::size_t point ) -> char
+{
+    const auto offset = static_cast<std::size_t>( source.empty() ? 0 : source.back() ) * 64;
+    return static_cast<char>( ( point + offset ) & 0xff );
+}
+
+scope_simulator::scope_simulator( simulator_options options )
+    : m_options{ options },
+      m_acceptor{ m_service, tcp::endpoint{ asio::ip::address_v4::loopback(), 0 } },
+      m_acceptor_thread{ [ this ] { accept_loop(); } }
+{
+}
+
+scope_simulator::~scope_simulator()
+{
+    m_stopping = true;
+
+    // Wake up the blocking accept with a throwaway connection
+    auto wakeup = tcp::socket{ m_service };
+    auto code = boost::system::error_code{};
+    wakeup.connect( m_acceptor.local_endpoint(), code );
+    m_acceptor_thread.join();
+
+    auto lock = std::lock_guard{ m_sessions_mutex };
+    for ( auto& sock : m_session_sockets )
+    {
+        sock->shutdown( tcp::socket::shutdown_both, code );
+    }
+
+    m_sessions.clear();
+}
+
+void
+scope_simulator::accept_loop()
+{
+    while ( true )
+    {
+        auto sock = std::make_shared<tcp::socket>( m_service );
+        auto code = boost::system::error_code{};
+        m_acceptor.accept( *sock, code );
+
+        if ( m_stopping || code )
+        {
+            return;
+        }
+
+        sock->set_option( tcp::no_delay{ true }, code );
+
+        auto lock = std::lock_guard{ m_sessions_mutex };
+        m_session_sockets.push_back( sock );
+        m_sessions.emplace_back( [ this, sock ] { serve( *sock ); } );
+    }
+}
+
+void
+scope_simulator::serve( tcp::socket& sock )
+{
+    auto state = session_state{};
+    auto buf = asio::streambuf{};
+    auto input = std::istream{ &buf };
+
+    auto code = boost::system::error_code{};
+    while ( asio::read_until( sock, buf, '\n', code ), !code )
+    {
+        auto line = std::string{};
+        std::getline( input, line );
+
+        if ( const auto reply = respond( line, state ); !reply.empty() )
+        {
+            asio::write( sock, asio::buffer( reply ), code );
+        }
+    }
+}
+
+auto
+scope_simulator::trigger_status( session_state& state ) -> std::string_view
+{
+    // Like the real instrument, :SING is applied asynchronously, and until then the previous status is reported
+    if ( state.single_pending )
+    {
+        if ( state.stale_polls-- > 0 )
+        {
+            return state.status;
+        }
+
+        arm_single( state );
+    }
+
+    if ( state.polls_until_stop >= 0 && state.polls_until_stop-- == 0 )
+    {
+        state.status = "STOP";
+        ++m_single_shots;
+    }
+
+    return state.status;
+}
+
+auto
+scope_simulator::serve_block( const session_state& state ) -> std::string
+{
+    // Counted while the block is being prepared, which is where concurrent sessions overlap
+    const auto in_flight = ++m_blocks_in_flight;
+    auto peak = m_peak_blocks_in_flight.load();
+    while ( in_flight > peak && !m_peak_blocks_in_flight.compare_exchange_weak( peak, in_flight ) )
+    {
+    }
+
+    std::this_thread::sleep_for( m_options.block_delay );
+    // Points past the memory depth are not returned, so the block comes out short just like on the instrument
+    auto block = make_block( state.source, state.start, std::min( state.stop, m_options.memory_depth ) );
+
+    --m_blocks_in_flight;
+    return block;
+}
+
+auto
+scope_simulator::respond( std::string_view line, session_state& state ) -> std::string
+{
+    const auto argument = [ line ]( std::string_view command ) { return line.substr( command.size() + 1 ); };
+
+    if ( line == "*IDN?" )
+    {
+        return "RIGOL TECHNOLOGIES,DS1054Z,DS1ZA000000000,00.04.05.SP2\n";
+    }
+
+    if ( line == "*OPC?" )
+    {
+        if ( state.single_pending )
+        {
+            arm_single( state );
+        }
+
+        return "1\n";
+    }
+
+    if ( line == ":ACQ:MDEP?" )
+    {
+        return fmt::format( "{}\n", m_options.memory_depth );
+    }
+
+    if ( line == ":SING" )
+    {
+        state.single_pending = true;
+        state.stale_polls = m_options.arming_polls;
+    } else if ( line == ":RUN" || line == ":STOP" )
+    {
+        state.single_pending = false;
+        state.polls_until_stop = -1;
+        state.status = line == ":RUN" ? "RUN" : "STOP";
+    } else if ( line == ":TRIG:STAT?" )
+    {
+        return fmt::format( "{}\n", trigger_status( state ) );
+    } else if ( line.starts_with( ":WAV:SOUR " ) )
+    {
+        state.source = argument( ":WAV:SOUR" );
+    } else if ( line.starts_with( ":WAV:STAR " ) )
+    {
+        state.start = parse_number( argument( ":WAV:STAR" ) );
+    } else if ( line.starts_with( ":WAV:STOP " ) )
+    {
+        state.stop = parse_number( argument( ":WAV:STOP" ) );
+    } else if ( line == ":WAV:DATA?" )
+    {
+        return serve_block( state );
+    }
+
+    return {};
+}
+
+} // namespace ds
@@ -0,0 +1,296 @@
+#include "dsview/dslib/socket_device.hpp"
+
+#include <boost/format.hpp>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace ds
+{
+
+namespace
+{
+
+[[noreturn]] void
+throw_errno( const char* what )
+{
+    throw std::system_error{ errno, std::generic_category(), what };
+}
+
+void
+set_option( int fd, int level, int name, int value, const char* what )
+{
+    if ( ::setsockopt( fd, level, name, &value, sizeof( value ) ) != 0 )
+    {
+        throw_errno( what );
+    }
+}
+
+} // namespace
+
+socket_device::socket_device( std::string_view host, std::string_view port, socket_options options )
+{
+    auto hints = addrinfo{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* raw_result = nullptr;
+    const auto host_str = std::string{ host };
+    const auto port_str = std::string{ port };
+    if ( ::getaddrinfo( host_str.c_str(), port_str.c_str(), &hints, &raw_result ) != 0 || !raw_result )
+    {
+        throw std::runtime_error{ str( boost::format( "Could not resolve address %s" ) % host ) };
+    }
+
+    auto result = std::unique_ptr<addrinfo, decltype( &::freeaddrinfo )>{ raw_result, &::freeaddrinfo };
+
+    m_fd = ::socket( result->ai_family, result->ai_socktype | SOCK_CLOEXEC, result->ai_protocol );
+    if ( m_fd < 0 )
+    {
+        throw_errno( "socket" );
+    }
+
+    try
+    {
+        // SO_RCVBUF has to be set before connect, otherwise the window scale is already negotiated
+        if ( options.receive_buffer_size > 0 )
+        {
+            set_option( m_fd, SOL_SOCKET, SO_RCVBUF, options.receive_buffer_size, "setsockopt(SO_RCVBUF)" );
+        }
+
+        if ( options.no_delay )
+        {
+            set_option( m_fd, IPPROTO_TCP, TCP_NODELAY, 1, "setsockopt(TCP_NODELAY)" );
+        }
+
+        while ( ::connect( m_fd, result->ai_addr, result->ai_addrlen ) != 0 )
+        {
+            if ( errno != EINTR )
+            {
+                throw_errno( "connect" );
+            }
+        }
+    } catch ( ... )
+    {
+        ::close( m_fd );
+        throw;
+    }
+}
+
+socket_device::~socket_device()
+{
+    if ( m_fd >= 0 )
+    {
+        ::close( m_fd );
+    }
+}
+
+auto
+socket_device::make_deadline( timeout_type timeout ) -> deadline_type
+{
+    if ( timeout == no_timeout )
+    {
+        return std::nullopt;
+    }
+
+    return clock_type::now() + timeout;
+}
+
+void
+socket_device::set_receive_timeout( timeout_type timeout )
+{
+    // Callers almost always pass the same timeout, so the option is only touched when it actually changes. A read that
+    // needs several recv calls shortens it towards its deadline, the next read call restores it.
+    if ( m_receive_timeout == timeout )
+    {
+        return;
+    }
+
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>( timeout );
+    auto tv = timeval{}; // Zero means block indefinitely for SO_RCVTIMEO, which matches no_timeout
+    tv.tv_sec = static_cast<decltype( tv.tv_sec )>( seconds.count() );
+    tv.tv_usec = static_cast<decltype( tv.tv_usec )>(
+        std::chrono::duration_cast<std::chrono::microseconds>( timeout - seconds ).count() );
+
+    if ( ::setsockopt( m_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) ) != 0 )
+    {
+        throw_errno( "setsockopt(SO_RCVTIMEO)" );
+    }
+
+    m_receive_timeout = timeout;
+}
+
+auto
+socket_device::recv_some( mutable_buffer_view dst, int flags, deadline_type deadline ) -> std::size_t
+{
+    while ( true )
+    {
+        // SO_RCVTIMEO bounds a single recv, the deadline bounds the whole public read call
+        if ( deadline )
+        {
+            const auto remaining = *deadline - clock_type::now();
+            if ( remaining <= clock_type::duration::zero() )
+            {
+                throw std::runtime_error{ "Timeout on read operation: socket_device::recv_some" };
+            }
+
+            // The first recv of a call gets the full timeout without another setsockopt. Later ones are shortened to
+            // what is left, so that a read ends at its deadline like the timer in lan_device does.
+            set_receive_timeout( std::min( *m_receive_timeout, std::chrono::ceil<timeout_type>( remaining ) ) );
+        }
+
+        const auto num_received = ::recv( m_fd, dst.data(), dst.size(), flags );
+        if ( num_received > 0 )
+        {
+            return static_cast<std::size_t>( num_received );
+        }
+
+        if ( num_received == 0 )
+        {
+            throw std::runtime_error{ "Connection closed by peer: socket_device::recv_some" };
+        }
+
+        if ( errno == EINTR )
+        {
+            continue;
+        }
+
+        // EWOULDBLOCK is an alias of EAGAIN on Linux, comparing both trips -Wlogical-op
+#if EAGAIN != EWOULDBLOCK
+        if ( errno == EAGAIN || errno == EWOULDBLOCK )
+#else
+        if ( errno == EAGAIN )
+#endif
+        {
+            throw std::runtime_error{ "Timeout on read operation: socket_device::recv_some" };
+        }
+
+        throw_errno( "recv" );
+    }
+}
+
+auto
+socket_device::consume_pending( mutable_buffer_view dst ) -> std::size_t
+{
+    const auto count = std::min( dst.size(), m_pending.size() );
+    std::copy_n( m_pending.begin(), count, dst.begin() );
+    m_pending.erase( m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>( count ) );
+    return count;
+}
+
+template <typename result_t>
+auto
+socket_device::read_until_impl( timeout_type timeout, std::string_view delim ) -> result_t
+{
+    set_receive_timeout( timeout );
+    const auto deadline = make_deadline( timeout );
+    auto search_from = std::size_t{ 0 };
+
+    while ( true )
+    {
+        const auto pending = std::string_view{ m_pending.data(), m_pending.size() };
+        if ( const auto found = pending.find( delim, search_from ); found != std::string_view::npos )
+        {
+            const auto end = m_pending.begin() + static_cast<std::ptrdiff_t>( found + delim.size() );
+            auto res = result_t( m_pending.begin(), end );
+            m_pending.erase( m_pending.begin(), end );
+            return res;
+        }
+
+        // The delimiter may straddle two chunks, so rescan its tail on the next pass
+        search_from = m_pending.size() < delim.size() ? 0 : m_pending.size() - delim.size() + 1;
+
+        // Receive straight into the tail of the pending buffer and trim it back to what actually arrived
+        const auto old_size = m_pending.size();
+        m_pending.resize( old_size + chunk_size );
+
+        try
+        {
+            const auto num_received = recv_some( mutable_buffer_view{ m_pending }.subspan( old_size ), 0, deadline );
+            m_pending.resize( old_size + num_received );
+        } catch ( ... )
+        {
+            m_pending.resize( old_size );
+            throw;
+        }
+    }
+}
+
+template <typename result_t>
+auto
+socket_device::read_n_impl( std::size_t n, timeout_type timeout ) -> result_t
+{
+    auto res = result_t( n, '\0' );
+    read_into( res, timeout );
+    return res;
+}
+
+void
+socket_device::read_into( mutable_buffer_view dst, timeout_type timeout )
+{
+    set_receive_timeout( timeout );
+    const auto deadline = make_deadline( timeout );
+    auto rest = dst.subspan( consume_pending( dst ) );
+
+    while ( !rest.empty() )
+    {
+        rest = rest.subspan( recv_some( rest, MSG_WAITALL, deadline ) );
+    }
+}
+
+void
+socket_device::write( buffer_view data )
+{
+    while ( !data.empty() )
+    {
+        const auto num_sent = ::send( m_fd, data.data(), data.size(), MSG_NOSIGNAL );
+        if ( num_sent < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+
+            throw_errno( "send" );
+        }
+
+        data = data.subspan( static_cast<std::size_t>( num_sent ) );
+    }
+}
+
+auto
+socket_device::read_until( as_vector_t, timeout_type timeout, std::string_view delim ) -> buffer_type
+{
+    return read_until_impl<buffer_type>( timeout, delim );
+}
+
+auto
+socket_device::read_until( as_string_t, timeout_type timeout, std::string_view delim ) -> std::string
+{
+    return read_until_impl<std::string>( timeout, delim );
+}
+
+auto
+socket_device::read_n( as_string_t, std::size_t n, timeout_type timeout ) -> std::string
+{
+    return read_n_impl<std::string>( n, timeout );
+}
+
+auto
+socket_device::read_n( as_vector_t, std::size_t n, timeout_type timeout ) -> buffer_type
+{
+    return read_n_impl<buffer_type>( n, timeout );
+}
+
+} // namespace ds
@@ -0,0 +1,153 @@
+#include "command_line.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+
+namespace dsview
+{
+
+namespace
+{
+
+auto
+parse_number( std::string_view str ) -> std::size_t
+{
+    auto result = std::size_t{};
+    if ( auto [ ptr, ec ] = std::from_chars( str.data(), str.data() + str.size(), result );
+         ec != std::errc{} || ptr != str.data() + str.size() )
+    {
+        throw std::invalid_argument{ fmt::format( "Expected a number, got '{}'", str ) };
+    }
+
+    return result;
+}
+
+// Keeps empty entries, including a trailing one, so that callers can reject them
+auto
+split_list( std::string_view list ) -> std::vector<std::string_view>
+{
+    auto result = std::vector<std::string_view>{};
+    if ( list.empty() )
+    {
+        return result;
+    }
+
+    for ( auto comma = list.find( ',' ); comma != std::string_view::npos; comma = list.find( ',' ) )
+    {
+        result.push_back( list.substr( 0, comma ) );
+        list.remove_prefix( comma + 1 );
+    }
+
+    result.push_back( list );
+    return result;
+}
+
+auto
+parse_scenarios( std::string_view list ) -> std::vector<scenario_kind>
+{
+    const auto names = split_list( list );
+    if ( names.empty() )
+    {
+        throw std::invalid_argument{ "Expected at least one scenario" };
+    }
+
+    auto result = std::vector<scenario_kind>{};
+    for ( auto name : names )
+    {
+        result.push_back( to_scenario( name ) );
+    }
+
+    return result;
+}
+
+auto
+parse_channels( std::string_view list ) -> std::vector<std::string>
+{
+    const auto names = split_list( list );
+    if ( names.empty() )
+    {
+        throw std::invalid_argument{ "Expected at least one channel" };
+    }
+
+    if ( std::any_of( names.begin(), names.end(), []( auto name ) { return name.empty(); } ) )
+    {
+        throw std::invalid_argument{ fmt::format( "Empty channel name in '{}'", list ) };
+    }
+
+    return { names.begin(), names.end() };
+}
+
+} // namespace
+
+auto
+parse_command_line( std::span<const std::string_view> args ) -> command_line
+{
+    auto result = command_line{};
+
+    for ( auto it = args.begin(); it != args.end(); ++it )
+    {
+        const auto value = [ & ] {
+            if ( std::next( it ) == args.end() )
+            {
+                throw std::invalid_argument{ fmt::format( "Missing value for {}", *it ) };
+            }
+
+            return *++it;
+        };
+
+        if ( *it == "--help" )
+        {
+            result.help = true;
+        } else if ( *it == "--sequential" )
+        {
+            result.sequential = true;
+        } else if ( *it == "--simulate" )
+        {
+            result.simulate = true;
+        } else if ( *it == "--simulate-delay" )
+        {
+            result.simulator.block_delay = std::chrono::microseconds{ parse_number( value() ) };
+        } else if ( *it == "--transport" )
+        {
+            result.transport = ds::to_transport( value() );
+        } else if ( *it == "--scenarios" )
+        {
+            result.profile.scenarios = parse_scenarios( value() );
+        } else if ( *it == "--iterations" )
+        {
+            result.profile.iterations = parse_number( value() );
+        } else if ( *it == "--fetch-iterations" )
+        {
+            result.profile.fetch_iterations = parse_number( value() );
+        } else if ( *it == "--batch" )
+        {
+            result.profile.batch_size = parse_number( value() );
+        } else if ( *it == "--points" )
+        {
+            result.profile.fetch_points = parse_number( value() );
+        } else if ( *it == "--channels" )
+        {
+            result.profile.channels = parse_channels( value() );
+        } else if ( *it == "--timeout" )
+        {
+            result.profile.timeout = std::chrono::milliseconds{ parse_number( value() ) };
+        } else if ( it->starts_with( "--" ) )
+        {
+            throw std::invalid_argument{ fmt::format( "Unknown option {}", *it ) };
+        } else
+        {
+            const auto colon = it->find( ':' );
+            const auto port = colon == std::string_view::npos ? std::to_string( ds::lan_device::device_port )
+                                                              : std::string{ it->substr( colon + 1 ) };
+            result.hosts.emplace_back( it->substr( 0, colon ), port );
+        }
+    }
+
+    return result;
+}
+
+} // namespace dsview
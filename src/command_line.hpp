@@ -0,0 +1,39 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "profiler.hpp"
+
+#include "dsview/simulator.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dsview
+{
+
+struct command_line
+{
+    profile_options profile;
+    ds::transport_kind transport = ds::transport_kind::e_posix;
+    std::vector<std::pair<std::string, std::string>> hosts;
+    bool sequential = false; //< Profile one host at a time instead of all of them at once
+    bool simulate = false;
+    ds::simulator_options simulator;
+    bool help = false;
+};
+
+// Parses the arguments that follow the program name, throws std::invalid_argument or std::out_of_range on bad input
+[[nodiscard]] auto parse_command_line( std::span<const std::string_view> args ) -> command_line;
+
+} // namespace dsview
@@ -1,34 +1,123 @@
 #include "dsview/dslib.hpp"
+#include "dsview/simulator.hpp"
 
-#include <fmt/core.h>
-#include <fmt/format.h>
+#include "command_line.hpp"
+#include "profiler.hpp"
 
-#include <array>
-#include <chrono>
+#include <algorithm>
+#include <exception>
 #include <iostream>
-#include <iterator>
-#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
-using namespace std::literals;
+namespace
+{
+
+constexpr auto usage = R"(Usage: dsview [options] [host[:port]...]
+
+Profiles query latency, throughput, waveform fetch rate and trigger rate of one or more scopes and prints the results
+as JSON. By default all hosts are profiled concurrently, each over its own connection. Hosts that share an uplink then
+compete for it and skew each other's latency and MB/s, use --sequential to compare instruments with each other.
+
+Options:
+  --transport asio|posix   Socket backend (default: posix)
+  --scenarios LIST         Comma separated subset of ping,batch,fetch,parallel-fetch,trigger (default: all)
+  --iterations N           Repetitions of ping, batch and trigger scenarios (default: 100)
+  --fetch-iterations N     Full memory readouts per device (default: 3)
+  --batch N                Queries in flight per batch (default: 32)
+  --points N               Points per fetch, 0 reads the whole acquisition memory (default: 0)
+  --channels LIST          Comma separated waveform sources for fetches (default: CHAN1)
+  --timeout MS             Per operation timeout in milliseconds, 0 waits forever (default: 5000)
+  --sequential             Profile one host at a time instead of all of them concurrently
+  --simulate               Add an in-process simulated scope to the host list
+  --simulate-delay US      Time the simulated scope spends preparing each waveform block (default: 0)
+  --help                   Show this message
+)";
+
+auto
+profile_host( const dsview::command_line& cmd, std::string host, std::string port ) -> dsview::device_report
+{
+    auto report = dsview::device_report{};
+    report.host = std::move( host );
+    report.port = std::move( port );
+
+    try
+    {
+        const auto factory = [ & ] { return ds::make_lan_device( cmd.transport, report.host, report.port ); };
+        auto device = factory();
+        report.identity = device->query<ds::scpi::common::idn_cmd>( cmd.profile.timeout );
+
+        for ( auto kind : cmd.profile.scenarios )
+        {
+            report.results.push_back( dsview::run_scenario( *device, factory, kind, cmd.profile ) );
+        }
+    } catch ( std::exception& e )
+    {
+        report.error = e.what();
+    }
+
+    return report;
+}
+
+} // namespace
 
 auto
-main() -> int
+main( int argc, char** argv ) -> int
 {
-    auto device = std::make_unique<ds::lan_device>( "192.168.50.78" );
+    auto cmd = dsview::command_line{};
+
+    try
+    {
+        const auto args = std::vector<std::string_view>( argv + 1, argv + argc );
+        cmd = dsview::parse_command_line( args );
+    } catch ( std::exception& e )
+    {
+        std::cerr << e.what() << "\n\n" << usage;
+        return 1;
+    }
+
+    if ( cmd.help || ( cmd.hosts.empty() && !cmd.simulate ) )
+    {
+        std::cerr << usage;
+        return cmd.help ? 0 : 1;
+    }
 
-    auto parsed = device->query<ds::scpi::common::idn_cmd>( ds::block_query, ds::lan_device::no_timeout );
-    if ( !parsed )
+    auto simulator = std::optional<ds::scope_simulator>{};
+    if ( cmd.simulate )
     {
-        std::cout << "Unavailable\n";
-        return 0;
+        simulator.emplace( cmd.simulator );
+        cmd.hosts.emplace_back( simulator->host(), simulator->port() );
     }
 
-    std::cout << fmt::format(
-        "Model: {}, Serial number: {}, Software version: {}\n",
-        to_string( parsed->model ),
-        parsed->serial_number,
-        parsed->software_version );
+    auto reports = std::vector<dsview::device_report>( cmd.hosts.size() );
+    const auto profile = [ & ]( std::size_t i ) {
+        const auto& [ host, port ] = cmd.hosts[ i ];
+        reports[ i ] = profile_host( cmd, host, port );
+    };
+
+    if ( cmd.sequential )
+    {
+        for ( auto i = std::size_t{ 0 }; i < cmd.hosts.size(); ++i )
+        {
+            profile( i );
+        }
+    } else
+    {
+        auto workers = std::vector<std::jthread>{};
+        for ( auto i = std::size_t{ 0 }; i < cmd.hosts.size(); ++i )
+        {
+            workers.emplace_back( profile, i );
+        }
+    }
+
+    std::cout << dsview::to_json( cmd.transport, reports );
+
+    const auto failed = std::any_of( reports.begin(), reports.end(), []( auto&& report ) {
+        return report.error.has_value();
+    } );
 
-    device->submit<ds::scpi::common::rst_cmd>();
+    return failed ? 1 : 0;
 }
@@ -0,0 +1,406 @@
+#include "profiler.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace dsview
+{
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+using microseconds = std::chrono::duration<double, std::micro>;
+
+namespace common = ds::scpi::common;
+namespace root = ds::scpi::root;
+namespace trigger = ds::scpi::trigger;
+namespace waveform = ds::scpi::waveform;
+
+// Nearest-rank percentile over sorted samples
+auto
+percentile( std::span<const sample_type> sorted, double fraction ) -> double
+{
+    const auto rank = static_cast<std::size_t>( std::ceil( fraction * static_cast<double>( sorted.size() ) ) );
+    return microseconds{ sorted[ std::clamp<std::size_t>( rank, 1, sorted.size() ) - 1 ] }.count();
+}
+
+auto
+measure( std::size_t iterations, auto&& func ) -> std::vector<sample_type>
+{
+    auto samples = std::vector<sample_type>{};
+    samples.reserve( iterations );
+
+    for ( auto i = std::size_t{ 0 }; i < iterations; ++i )
+    {
+        const auto start = clock_type::now();
+        func();
+        samples.push_back( clock_type::now() - start );
+    }
+
+    return samples;
+}
+
+auto
+total_seconds( std::span<const sample_type> samples ) -> double
+{
+    return std::chrono::duration<double>{ std::accumulate( samples.begin(), samples.end(), sample_type{} ) }.count();
+}
+
+auto
+make_result( scenario_kind kind, std::vector<sample_type> samples, std::size_t operations ) -> scenario_result
+{
+    const auto seconds = total_seconds( samples );
+
+    auto result = scenario_result{};
+    result.kind = kind;
+    result.latency = summarize( std::move( samples ) );
+    result.rate_hz = seconds > 0 ? static_cast<double>( operations ) / seconds : 0;
+    return result;
+}
+
+// Puts the scope back into RUN however a scenario ends, a failed run must not leave it stopped or armed
+class resume_acquisition
+{
+  public:
+    explicit resume_acquisition( ds::idevice& device )
+        : m_device{ device }
+    {
+    }
+
+    resume_acquisition( const resume_acquisition& ) = delete;
+    auto operator=( const resume_acquisition& ) -> resume_acquisition& = delete;
+
+    ~resume_acquisition()
+    {
+        try
+        {
+            m_device.submit<root::run_cmd>();
+        } catch ( ... )
+        {
+            // The connection may already be gone, and the error that ended the scenario is the one worth reporting
+        }
+    }
+
+  private:
+    ds::idevice& m_device;
+};
+
+void
+wait_operation_complete( ds::idevice& device, const profile_options& options )
+{
+    if ( !device.query<common::opc_cmd>( options.timeout ) )
+    {
+        throw std::runtime_error{ "Device reported pending operations on *OPC?" };
+    }
+}
+
+auto
+run_ping( ds::idevice& device, const profile_options& options ) -> scenario_result
+{
+    auto samples = measure( options.iterations, [ & ] { wait_operation_complete( device, options ); } );
+
+    return make_result( scenario_kind::e_ping, std::move( samples ), options.iterations );
+}
+
+auto
+run_batch( ds::idevice& device, const profile_options& options ) -> scenario_result
+{
+    auto batch = std::string{};
+    for ( auto i = std::size_t{ 0 }; i < options.batch_size; ++i )
+    {
+        batch += fmt::format( "{}\n", std::string_view{ common::idn_cmd::get_query_string() } );
+    }
+
+    auto samples = measure( options.iterations, [ & ] {
+        device.write( batch );
+
+        // A single read may return several responses at once, so count terminators instead of reads
+        for ( auto answered = std::size_t{ 0 }; answered < options.batch_size; )
+        {
+            const auto response = device.read_until( ds::as_string, options.timeout, "\n" );
+            answered += static_cast<std::size_t>( std::count( response.begin(), response.end(), '\n' ) );
+        }
+    } );
+
+    return make_result( scenario_kind::e_batch, std::move( samples ), options.iterations * options.batch_size );
+}
+
+auto
+memory_depth( ds::idevice& device, const profile_options& options ) -> std::size_t
+{
+    if ( options.fetch_points != 0 )
+    {
+        return options.fetch_points;
+    }
+
+    const auto depth = device.query<waveform::memory_depth_cmd>( options.timeout );
+    if ( !depth )
+    {
+        throw std::runtime_error{ "Memory depth is AUTO, pass an explicit number of points" };
+    }
+
+    return *depth;
+}
+
+auto
+make_fetch_result(
+    scenario_kind kind,
+    std::vector<sample_type> samples,
+    std::size_t bytes,
+    const profile_options& options ) -> scenario_result
+{
+    const auto seconds = total_seconds( samples );
+    auto result = make_result( kind, std::move( samples ), options.fetch_iterations );
+    result.bytes = bytes;
+    result.megabytes_per_second = seconds > 0 ? static_cast<double>( bytes ) / seconds / 1e6 : 0;
+    return result;
+}
+
+auto
+run_fetch( ds::idevice& device, const profile_options& options ) -> scenario_result
+{
+    if ( options.channels.empty() )
+    {
+        throw std::invalid_argument{ "Expected at least one channel" };
+    }
+
+    const auto resume = resume_acquisition{ device };
+    device.submit<root::stop_cmd>();
+    const auto points = memory_depth( device, options );
+
+    auto buffer = ds::idevice::buffer_type( points );
+    auto bytes = std::size_t{ 0 };
+
+    // Set up RAW/BYTE once outside the timed region, the same as parallel_channel_fetcher does in its constructor.
+    // Only the source has to change between channels on a shared connection, so that is all that gets timed.
+    ds::setup_waveform( device, options.channels.front() );
+
+    auto samples = measure( options.fetch_iterations, [ & ] {
+        for ( const auto& channel : options.channels )
+        {
+            device.submit<waveform::source_cmd>( std::string_view{ channel } );
+            bytes += ds::read_waveform( device, buffer, points, options.timeout );
+        }
+    } );
+
+    return make_fetch_result( scenario_kind::e_fetch, std::move( samples ), bytes, options );
+}
+
+auto
+run_parallel_fetch(
+    ds::idevice& device,
+    const ds::parallel_channel_fetcher::device_factory& factory,
+    const profile_options& options ) -> scenario_result
+{
+    const auto resume = resume_acquisition{ device };
+    device.submit<root::stop_cmd>();
+
+    auto fetcher = ds::parallel_channel_fetcher{ factory, options.channels, memory_depth( device, options ) };
+    auto bytes = std::size_t{ 0 };
+
+    auto samples = measure( options.fetch_iterations, [ & ] {
+        fetcher.fetch( options.timeout );
+        bytes += fetcher.bytes_received();
+    } );
+
+    return make_fetch_result( scenario_kind::e_parallel_fetch, std::move( samples ), bytes, options );
+}
+
+auto
+run_trigger( ds::idevice& device, const profile_options& options ) -> scenario_result
+{
+    const auto resume = resume_acquisition{ device };
+    auto samples = measure( options.iterations, [ & ] {
+        const auto deadline = clock_type::now() + options.timeout;
+        device.submit<root::single_cmd>();
+
+        // The previous shot left the scope in STOP, which it keeps reporting until :SING is actually processed.
+        // Synchronize first, otherwise a single status round trip would be counted as a trigger.
+        wait_operation_complete( device, options );
+
+        while ( device.query<trigger::status_cmd>( options.timeout ) != trigger::trigger_status::e_stop )
+        {
+            // A zero timeout means no timeout, the same as for the reads themselves
+            if ( options.timeout != ds::idevice::no_timeout && clock_type::now() > deadline )
+            {
+                throw std::runtime_error{ "Timeout waiting for a single shot trigger" };
+            }
+        }
+    } );
+
+    return make_result( scenario_kind::e_trigger, std::move( samples ), options.iterations );
+}
+
+void
+append_result( std::string& out, const scenario_result& result )
+{
+    const auto& latency = result.latency;
+    fmt::format_to(
+        std::back_inserter( out ),
+        R"({{"name":"{}","count":{},"rate_hz":{:.3f},"latency_us":{{"min":{:.1f},"mean":{:.1f},"p50":{:.1f},)"
+        R"("p90":{:.1f},"p99":{:.1f},"max":{:.1f}}})",
+        to_string( result.kind ),
+        latency.count,
+        result.rate_hz,
+        latency.min_us,
+        latency.mean_us,
+        latency.p50_us,
+        latency.p90_us,
+        latency.p99_us,
+        latency.max_us );
+
+    if ( result.bytes )
+    {
+        fmt::format_to( std::back_inserter( out ), R"(,"bytes":{})", *result.bytes );
+    }
+
+    if ( result.megabytes_per_second )
+    {
+        fmt::format_to( std::back_inserter( out ), R"(,"mb_per_s":{:.3f})", *result.megabytes_per_second );
+    }
+
+    out += '}';
+}
+
+} // namespace
+
+auto
+escape_json( std::string_view str ) -> std::string
+{
+    auto result = std::string{};
+    result.reserve( str.size() );
+
+    for ( auto c : str )
+    {
+        switch ( c )
+        {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        default:
+            if ( static_cast<unsigned char>( c ) < 0x20 )
+            {
+                result += fmt::format( "\\u{:04x}", static_cast<unsigned>( c ) );
+            } else
+            {
+                result += c;
+            }
+        }
+    }
+
+    return result;
+}
+
+auto
+summarize( std::vector<sample_type> samples ) -> latency_summary
+{
+    if ( samples.empty() )
+    {
+        return {};
+    }
+
+    std::sort( samples.begin(), samples.end() );
+    const auto total = std::accumulate( samples.begin(), samples.end(), sample_type{} );
+
+    return latency_summary{
+        .count = samples.size(),
+        .min_us = microseconds{ samples.front() }.count(),
+        .mean_us = microseconds{ total }.count() / static_cast<double>( samples.size() ),
+        .p50_us = percentile( samples, 0.50 ),
+        .p90_us = percentile( samples, 0.90 ),
+        .p99_us = percentile( samples, 0.99 ),
+        .max_us = microseconds{ samples.back() }.count() };
+}
+
+auto
+run_scenario(
+    ds::idevice& device,
+    const ds::parallel_channel_fetcher::device_factory& factory,
+    scenario_kind kind,
+    const profile_options& options ) -> scenario_result
+{
+    switch ( kind )
+    {
+    case scenario_kind::e_ping:
+        return run_ping( device, options );
+    case scenario_kind::e_batch:
+        return run_batch( device, options );
+    case scenario_kind::e_fetch:
+        return run_fetch( device, options );
+    case scenario_kind::e_parallel_fetch:
+        return run_parallel_fetch( device, factory, options );
+    case scenario_kind::e_trigger:
+        return run_trigger( device, options );
+    }
+
+    throw std::out_of_range{ "Scenario kind is unknown" };
+}
+
+auto
+to_json( ds::transport_kind transport, std::span<const device_report> reports ) -> std::string
+{
+    auto out = fmt::format( R"({{"transport":"{}","devices":[)", to_string( transport ) );
+
+    for ( auto it = reports.begin(); it != reports.end(); ++it )
+    {
+        if ( it != reports.begin() )
+        {
+            out += ',';
+        }
+
+        fmt::format_to(
+            std::back_inserter( out ),
+            R"({{"host":"{}","port":"{}")",
+            escape_json( it->host ),
+            escape_json( it->port ) );
+
+        if ( it->identity )
+        {
+            fmt::format_to(
+                std::back_inserter( out ),
+                R"(,"model":"{}","serial_number":"{}","software_version":"{}")",
+                escape_json( to_string( it->identity->model ) ),
+                escape_json( it->identity->serial_number ),
+                escape_json( it->identity->software_version ) );
+        }
+
+        // An array rather than an object keyed by name, the same scenario may be requested more than once
+        out += R"(,"scenarios":[)";
+        for ( auto result = it->results.begin(); result != it->results.end(); ++result )
+        {
+            if ( result != it->results.begin() )
+            {
+                out += ',';
+            }
+
+            append_result( out, *result );
+        }
+
+        out += ']';
+
+        if ( it->error )
+        {
+            fmt::format_to( std::back_inserter( out ), R"(,"error":"{}")", escape_json( *it->error ) );
+        }
+
+        out += '}';
+    }
+
+    out += "]}\n";
+    return out;
+}
+
+} // namespace dsview
@@ -0,0 +1,133 @@
+/*
+ * ----------------------------------------------------------------------------
+ *  "THE BEER-WARE LICENSE" (Revision 42):
+ *  <tsimmerman.ss@phystech.edu> wrote this file. As long as you retain this notice you
+ *  can do whatever you want with this stuff. If we meet some day, and you think
+ *  this stuff is worth it, you can buy me a beer in return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "dsview/dslib.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dsview
+{
+
+enum class scenario_kind
+{
+    e_ping,           //< *OPC? round trip
+    e_batch,          //< Pipelined *IDN? queries
+    e_fetch,          //< Full memory :WAV:DATA? readout of every channel in turn over one connection
+    e_parallel_fetch, //< Same readout with one connection per channel
+    e_trigger,        //< :SING followed by :TRIG:STAT? polling until STOP
+};
+
+static constexpr auto all_scenarios = std::to_array(
+    { scenario_kind::e_ping,
+      scenario_kind::e_batch,
+      scenario_kind::e_fetch,
+      scenario_kind::e_parallel_fetch,
+      scenario_kind::e_trigger } );
+
+[[nodiscard]] constexpr auto
+to_string( scenario_kind kind ) -> std::string_view
+{
+    switch ( kind )
+    {
+    case scenario_kind::e_ping:
+        return "ping";
+    case scenario_kind::e_batch:
+        return "batch";
+    case scenario_kind::e_fetch:
+        return "fetch";
+    case scenario_kind::e_parallel_fetch:
+        return "parallel-fetch";
+    case scenario_kind::e_trigger:
+        return "trigger";
+    }
+
+    throw std::out_of_range{ "Scenario kind is unknown" };
+}
+
+[[nodiscard]] constexpr auto
+to_scenario( std::string_view name ) -> scenario_kind
+{
+    for ( auto kind : all_scenarios )
+    {
+        if ( to_string( kind ) == name )
+        {
+            return kind;
+        }
+    }
+
+    throw std::out_of_range{ "Scenario name is unknown" };
+}
+
+struct profile_options
+{
+    std::vector<scenario_kind> scenarios{ all_scenarios.begin(), all_scenarios.end() };
+    std::size_t iterations = 100;     //< Repetitions of ping, batch and trigger scenarios
+    std::size_t fetch_iterations = 3; //< Full memory readouts are slow, so they get their own count
+    std::size_t batch_size = 32;      //< Queries in flight per batch
+    std::size_t fetch_points = 0;     //< Points per fetch, 0 reads the whole acquisition memory
+    std::vector<std::string> channels{ "CHAN1" };
+    ds::idevice::timeout_type timeout = std::chrono::seconds{ 5 };
+};
+
+struct latency_summary
+{
+    std::size_t count = 0;
+    double min_us = 0;
+    double mean_us = 0;
+    double p50_us = 0;
+    double p90_us = 0;
+    double p99_us = 0;
+    double max_us = 0;
+};
+
+struct scenario_result
+{
+    scenario_kind kind;
+    latency_summary latency;
+    double rate_hz = 0; //< Operations per second: pings, queries, fetches or triggers
+    std::optional<std::size_t> bytes;
+    std::optional<double> megabytes_per_second;
+};
+
+struct device_report
+{
+    std::string host;
+    std::string port;
+    std::optional<ds::scpi::common::identify_result> identity;
+    std::vector<scenario_result> results;
+    std::optional<std::string> error;
+};
+
+using sample_type = std::chrono::steady_clock::duration;
+
+[[nodiscard]] auto summarize( std::vector<sample_type> samples ) -> latency_summary;
+
+// The factory opens additional connections to the same instrument for scenarios that need more than one
+[[nodiscard]] auto run_scenario(
+    ds::idevice& device,
+    const ds::parallel_channel_fetcher::device_factory& factory,
+    scenario_kind kind,
+    const profile_options& options ) -> scenario_result;
+
+// Escapes a string for use inside a JSON string literal
+[[nodiscard]] auto escape_json( std::string_view str ) -> std::string;
+
+[[nodiscard]] auto to_json( ds::transport_kind transport, std::span<const device_report> reports ) -> std::string;
+
+} // namespace dsview
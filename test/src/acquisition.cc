@@ -0,0 +1,107 @@
+#include "dsview/dslib/acquisition.hpp"
+#include "dsview/dslib/scpi/commands/waveform.hpp"
+#include "dsview/dslib/transport.hpp"
+#include "dsview/simulator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr auto max_points_per_read = ds::scpi::waveform::data_cmd::query_parser::max_points_per_read;
+
+TEST( dslib, parallel_channel_fetch ) // [NOLINT]
+{
+    const auto channels = std::vector<std::string>{ "CHAN1", "CHAN2", "CHAN3", "CHAN4" };
+    const auto points = max_points_per_read * 2 + 1000; // Spans several :WAV:DATA? blocks
+
+    for ( auto kind : { ds::transport_kind::e_asio, ds::transport_kind::e_posix } )
+    {
+        auto simulator = ds::scope_simulator{};
+        auto fetcher = ds::parallel_channel_fetcher{
+            [ & ] { return ds::make_lan_device( kind, simulator.host(), simulator.port() ); },
+            channels,
+            points };
+
+        for ( auto round = 0; round < 2; ++round )
+        {
+            fetcher.fetch();
+            ASSERT_EQ( fetcher.size(), channels.size() );
+            EXPECT_EQ( fetcher.bytes_received(), points * channels.size() );
+
+            for ( auto i = std::size_t{ 0 }; i < fetcher.size(); ++i )
+            {
+                const auto data = fetcher.data( i );
+                ASSERT_EQ( data.size(), points ) << to_string( kind );
+                EXPECT_EQ( fetcher.channel( i ), channels[ i ] );
+
+                auto expected = std::vector<char>( points );
+                for ( auto point = std::size_t{ 0 }; point < points; ++point )
+                {
+                    expected[ point ] = ds::simulated_sample( channels[ i ], point + 1 );
+                }
+
+                EXPECT_TRUE( std::equal( data.begin(), data.end(), expected.begin() ) )
+                    << to_string( kind ) << " " << channels[ i ];
+            }
+        }
+    }
+}
+
+TEST( dslib, short_waveform_block ) // [NOLINT]
+{
+    auto options = ds::simulator_options{};
+    options.memory_depth = max_points_per_read + 1000;
+
+    for ( auto kind : { ds::transport_kind::e_asio, ds::transport_kind::e_posix } )
+    {
+        auto simulator = ds::scope_simulator{ options };
+        auto device = ds::make_lan_device( kind, simulator.host(), simulator.port() );
+        ds::setup_waveform( *device, "CHAN1" );
+
+        // The second block asks for points past the memory depth and comes back short
+        const auto points = max_points_per_read * 2;
+        auto buffer = ds::idevice::buffer_type( points );
+        EXPECT_THROW( ds::read_waveform( *device, buffer, points, ds::idevice::default_timeout ), std::runtime_error )
+            << to_string( kind );
+
+        // The short block was consumed whole, so the connection is still usable
+        EXPECT_EQ(
+            ds::read_waveform( *device, buffer, options.memory_depth, ds::idevice::default_timeout ),
+            options.memory_depth )
+            << to_string( kind );
+    }
+}
+
+TEST( dslib, parallel_channel_fetch_overlaps ) // [NOLINT]
+{
+    using namespace std::literals;
+
+    const auto channels = std::vector<std::string>{ "CHAN1", "CHAN2", "CHAN3", "CHAN4" };
+    constexpr auto block_delay = 50ms;
+
+    for ( auto kind : { ds::transport_kind::e_asio, ds::transport_kind::e_posix } )
+    {
+        auto options = ds::simulator_options{};
+        options.block_delay = block_delay;
+        auto simulator = ds::scope_simulator{ options };
+
+        auto fetcher = ds::parallel_channel_fetcher{
+            [ & ] { return ds::make_lan_device( kind, simulator.host(), simulator.port() ); },
+            channels,
+            max_points_per_read };
+
+        // The delay keeps every block in flight long enough for the others to catch up. Wall-clock time is not checked,
+        // it is too noisy on a loaded machine.
+        fetcher.fetch();
+        EXPECT_GT( simulator.peak_blocks_in_flight(), 1u ) << to_string( kind );
+    }
+}
+
+} // namespace
@@ -0,0 +1,290 @@
+#include "command_line.hpp"
+#include "profiler.hpp"
+
+#include "dsview/simulator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+using namespace std::literals;
+
+auto
+parse( std::initializer_list<std::string_view> args ) -> dsview::command_line
+{
+    return dsview::parse_command_line( std::vector<std::string_view>( args ) );
+}
+
+TEST( dslib, profiler_summary_empty ) // [NOLINT]
+{
+    const auto summary = dsview::summarize( {} );
+    EXPECT_EQ( summary.count, 0u );
+    EXPECT_EQ( summary.min_us, 0 );
+    EXPECT_EQ( summary.p50_us, 0 );
+    EXPECT_EQ( summary.p99_us, 0 );
+    EXPECT_EQ( summary.max_us, 0 );
+}
+
+TEST( dslib, profiler_summary_single_sample ) // [NOLINT]
+{
+    const auto summary = dsview::summarize( { 42us } );
+    EXPECT_EQ( summary.count, 1u );
+
+    for ( auto value :
+          { summary.min_us, summary.mean_us, summary.p50_us, summary.p90_us, summary.p99_us, summary.max_us } )
+    {
+        EXPECT_DOUBLE_EQ( value, 42 );
+    }
+}
+
+TEST( dslib, profiler_summary_nearest_rank ) // [NOLINT]
+{
+    // 100us down to 1us, summarize has to sort them itself
+    auto samples = std::vector<dsview::sample_type>{};
+    for ( auto i = 100; i > 0; --i )
+    {
+        samples.push_back( std::chrono::microseconds{ i } );
+    }
+
+    const auto summary = dsview::summarize( samples );
+    EXPECT_EQ( summary.count, 100u );
+    EXPECT_DOUBLE_EQ( summary.min_us, 1 );
+    EXPECT_DOUBLE_EQ( summary.mean_us, 50.5 );
+    EXPECT_DOUBLE_EQ( summary.p50_us, 50 );
+    EXPECT_DOUBLE_EQ( summary.p90_us, 90 );
+    EXPECT_DOUBLE_EQ( summary.p99_us, 99 );
+    EXPECT_DOUBLE_EQ( summary.max_us, 100 );
+}
+
+TEST( dslib, profiler_escape_json ) // [NOLINT]
+{
+    EXPECT_EQ( dsview::escape_json( "DS1054Z" ), "DS1054Z" );
+    EXPECT_EQ( dsview::escape_json( R"(say "hi" \o/)" ), R"(say \"hi\" \\o/)" );
+    EXPECT_EQ( dsview::escape_json( "a\nb" ), R"(a\nb)" );
+    EXPECT_EQ( dsview::escape_json( "\x01\t\x1f" ), R"(\u0001\u0009\u001f)" );
+    EXPECT_EQ( dsview::escape_json( "\x7f\xc2\xb5" ), "\x7f\xc2\xb5" ); // DEL and UTF-8 pass through
+}
+
+TEST( dslib, profiler_json_report ) // [NOLINT]
+{
+    auto ping = dsview::scenario_result{};
+    ping.kind = dsview::scenario_kind::e_ping;
+    ping.latency = dsview::summarize( { 10us } );
+    ping.rate_hz = 100'000;
+
+    auto fetch = dsview::scenario_result{};
+    fetch.kind = dsview::scenario_kind::e_fetch;
+    fetch.bytes = 1200;
+    fetch.megabytes_per_second = 1.5;
+
+    auto ok = dsview::device_report{};
+    ok.host = "scope";
+    ok.port = "5555";
+    ok.results = { ping, ping, fetch };
+
+    auto failed = dsview::device_report{};
+    failed.host = "10.0.0.1";
+    failed.port = "5555";
+    failed.error = "Timeout on \"read\"\nconnection\x01lost";
+
+    const auto reports = std::vector{ ok, failed };
+    const auto json = dsview::to_json( ds::transport_kind::e_posix, reports );
+
+    EXPECT_TRUE( json.starts_with( R"({"transport":"posix","devices":[{"host":"scope","port":"5555","scenarios":[)" ) );
+    EXPECT_TRUE( json.ends_with( "]}\n" ) );
+
+    // Repeated scenarios stay separate entries instead of duplicate keys
+    auto names = std::size_t{ 0 };
+    for ( auto pos = json.find( R"({"name":"ping")" ); pos != std::string::npos;
+          pos = json.find( R"({"name":"ping")", pos + 1 ) )
+    {
+        ++names;
+    }
+
+    EXPECT_EQ( names, 2u );
+    EXPECT_NE( json.find( R"("bytes":1200,"mb_per_s":1.500})" ), std::string::npos );
+
+    const auto error = R"({"host":"10.0.0.1","port":"5555","scenarios":[],)"
+                       R"("error":"Timeout on \"read\"\nconnection\u0001lost"})";
+    EXPECT_NE( json.find( error ), std::string::npos ) << json;
+    EXPECT_EQ( json.find( "\"error\"" ), json.rfind( "\"error\"" ) ); // Only the failed device has one
+    EXPECT_EQ( std::count( json.begin(), json.end(), '\n' ), 1 );
+}
+
+TEST( dslib, profiler_command_line ) // [NOLINT]
+{
+    const auto defaults = parse( {} );
+    EXPECT_EQ( defaults.transport, ds::transport_kind::e_posix );
+    EXPECT_EQ( defaults.profile.channels, std::vector<std::string>{ "CHAN1" } );
+    EXPECT_EQ( defaults.profile.scenarios.size(), dsview::all_scenarios.size() );
+    EXPECT_TRUE( defaults.hosts.empty() );
+    EXPECT_FALSE( defaults.sequential );
+
+    const auto cmd = parse(
+        { "--transport",
+          "asio",
+          "--scenarios",
+          "fetch,ping",
+          "--channels",
+          "CHAN2,CHAN4",
+          "--timeout",
+          "250",
+          "--simulate-delay",
+          "10",
+          "--sequential",
+          "192.168.1.5",
+          "scope:5025" } );
+
+    EXPECT_EQ( cmd.transport, ds::transport_kind::e_asio );
+    EXPECT_EQ(
+        cmd.profile.scenarios,
+        ( std::vector{ dsview::scenario_kind::e_fetch, dsview::scenario_kind::e_ping } ) );
+    EXPECT_EQ( cmd.profile.channels, ( std::vector<std::string>{ "CHAN2", "CHAN4" } ) );
+    EXPECT_EQ( cmd.profile.timeout, 250ms );
+    EXPECT_EQ( cmd.simulator.block_delay, 10us );
+    EXPECT_TRUE( cmd.sequential );
+    ASSERT_EQ( cmd.hosts.size(), 2u );
+    EXPECT_EQ( cmd.hosts[ 0 ], std::pair( "192.168.1.5"s, std::to_string( ds::lan_device::device_port ) ) );
+    EXPECT_EQ( cmd.hosts[ 1 ], std::pair( "scope"s, "5025"s ) );
+}
+
+TEST( dslib, profiler_command_line_errors ) // [NOLINT]
+{
+    EXPECT_THROW( parse( { "--channels", "CHAN1,,CHAN2" } ), std::invalid_argument );
+    EXPECT_THROW( parse( { "--channels", "CHAN1," } ), std::invalid_argument );
+    EXPECT_THROW( parse( { "--channels", "" } ), std::invalid_argument );
+    EXPECT_THROW( parse( { "--iterations" } ), std::invalid_argument );
+    EXPECT_THROW( parse( { "--iterations", "10x" } ), std::invalid_argument );
+    EXPECT_THROW( parse( { "--verbose" } ), std::invalid_argument );
+    EXPECT_THROW( parse( { "--scenarios", "" } ), std::invalid_argument );
+    EXPECT_THROW( parse( { "--scenarios", "ping,,fetch" } ), std::out_of_range );
+    EXPECT_THROW( parse( { "--scenarios", "ping,idle" } ), std::out_of_range );
+    EXPECT_THROW( parse( { "--transport", "serial" } ), std::out_of_range );
+}
+
+TEST( dslib, profiler_ping_and_batch ) // [NOLINT]
+{
+    for ( auto kind : { ds::transport_kind::e_asio, ds::transport_kind::e_posix } )
+    {
+        auto simulator = ds::scope_simulator{};
+        const auto factory = [ & ] { return ds::make_lan_device( kind, simulator.host(), simulator.port() ); };
+
+        auto profile = dsview::profile_options{};
+        profile.iterations = 10;
+        profile.batch_size = 16;
+        auto device = factory();
+
+        const auto ping = dsview::run_scenario( *device, factory, dsview::scenario_kind::e_ping, profile );
+        EXPECT_EQ( ping.latency.count, profile.iterations ) << to_string( kind );
+
+        // lan_device hands back everything buffered so far while socket_device stops at the delimiter, either way
+        // every response of every batch has to be consumed before the next one is sent
+        const auto batch = dsview::run_scenario( *device, factory, dsview::scenario_kind::e_batch, profile );
+        EXPECT_EQ( batch.latency.count, profile.iterations ) << to_string( kind );
+
+        // Nothing is left over from the batches to be mistaken for this answer
+        EXPECT_TRUE( device->query<ds::scpi::common::opc_cmd>() ) << to_string( kind );
+    }
+}
+
+TEST( dslib, profiler_fetch ) // [NOLINT]
+{
+    constexpr auto max_points_per_read = ds::scpi::waveform::data_cmd::query_parser::max_points_per_read;
+
+    auto options = ds::simulator_options{};
+    options.memory_depth = max_points_per_read + 1000; // Spans two :WAV:DATA? blocks
+
+    for ( auto kind : { ds::transport_kind::e_asio, ds::transport_kind::e_posix } )
+    {
+        auto simulator = ds::scope_simulator{ options };
+        const auto factory = [ & ] { return ds::make_lan_device( kind, simulator.host(), simulator.port() ); };
+
+        auto profile = dsview::profile_options{};
+        profile.fetch_iterations = 2;
+        profile.channels = { "CHAN1", "CHAN2" };
+        auto device = factory();
+
+        // fetch_points is left at 0, so the number of points comes from :ACQ:MDEP?
+        const auto result = dsview::run_scenario( *device, factory, dsview::scenario_kind::e_fetch, profile );
+        EXPECT_EQ( result.latency.count, profile.fetch_iterations ) << to_string( kind );
+        ASSERT_TRUE( result.bytes ) << to_string( kind );
+        EXPECT_EQ( *result.bytes, profile.fetch_iterations * options.memory_depth * profile.channels.size() )
+            << to_string( kind );
+
+        profile.channels.clear();
+        EXPECT_THROW(
+            static_cast<void>( dsview::run_scenario( *device, factory, dsview::scenario_kind::e_fetch, profile ) ),
+            std::invalid_argument )
+            << to_string( kind );
+    }
+}
+
+TEST( dslib, profiler_trigger_waits_for_single ) // [NOLINT]
+{
+    // The simulator keeps reporting the previous STOP for a few polls after :SING, a profiler that does not sync
+    // with the instrument returns early and the simulator never completes most of the single shots
+    auto options = ds::simulator_options{};
+    options.arming_polls = 3;
+    auto simulator = ds::scope_simulator{ options };
+
+    const auto factory = [ & ] {
+        return ds::make_lan_device( ds::transport_kind::e_posix, simulator.host(), simulator.port() );
+    };
+
+    auto profile = dsview::profile_options{};
+    profile.iterations = 20;
+    auto device = factory();
+
+    const auto result = dsview::run_scenario( *device, factory, dsview::scenario_kind::e_trigger, profile );
+    EXPECT_EQ( result.latency.count, profile.iterations );
+    EXPECT_EQ( simulator.single_shots(), profile.iterations );
+}
+
+TEST( dslib, profiler_resumes_acquisition_on_failure ) // [NOLINT]
+{
+    auto simulator = ds::scope_simulator{};
+    auto device = ds::make_lan_device( ds::transport_kind::e_posix, simulator.host(), simulator.port() );
+
+    // The extra connections fail after the scenario has already sent :STOP
+    const auto failing_factory = []() -> std::unique_ptr<ds::idevice> {
+        throw std::runtime_error{ "Connection refused" };
+    };
+
+    auto profile = dsview::profile_options{};
+    EXPECT_THROW(
+        static_cast<void>(
+            dsview::run_scenario( *device, failing_factory, dsview::scenario_kind::e_parallel_fetch, profile ) ),
+        std::runtime_error );
+
+    EXPECT_EQ( device->query<ds::scpi::trigger::status_cmd>(), ds::scpi::trigger::trigger_status::e_run );
+}
+
+TEST( dslib, profiler_trigger_without_timeout ) // [NOLINT]
+{
+    auto simulator = ds::scope_simulator{};
+    const auto factory = [ & ] {
+        return ds::make_lan_device( ds::transport_kind::e_posix, simulator.host(), simulator.port() );
+    };
+
+    auto profile = dsview::profile_options{};
+    profile.iterations = 5;
+    profile.timeout = ds::idevice::no_timeout; // What --timeout 0 parses to
+    auto device = factory();
+
+    const auto result = dsview::run_scenario( *device, factory, dsview::scenario_kind::e_trigger, profile );
+    EXPECT_EQ( result.latency.count, profile.iterations );
+    EXPECT_EQ( simulator.single_shots(), profile.iterations );
+    EXPECT_EQ( parse( { "--timeout", "0" } ).profile.timeout, ds::idevice::no_timeout );
+}
+
+} // namespace
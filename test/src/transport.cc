@@ -0,0 +1,165 @@
+#include "dsview/dslib/transport.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace asio = ds::asio;
+using ds::tcp;
+
+using namespace std::literals;
+
+constexpr auto transports = std::to_array( { ds::transport_kind::e_asio, ds::transport_kind::e_posix } );
+
+// Accepts a single connection on the loopback interface, sends the payload after an optional delay and holds the
+// connection open until the client hangs up.
+class loopback_server
+{
+  public:
+    explicit loopback_server( std::string payload, std::chrono::milliseconds delay = {} )
+        : m_acceptor{ m_service, tcp::endpoint{ asio::ip::address_v4::loopback(), 0 } },
+          m_thread{ [ this, payload = std::move( payload ), delay ] {
+              auto sock = m_acceptor.accept();
+              std::this_thread::sleep_for( delay );
+              asio::write( sock, asio::buffer( payload ) );
+
+              auto ignored = std::array<char, 1>{};
+              auto code = boost::system::error_code{};
+              asio::read( sock, asio::buffer( ignored ), code );
+          } }
+    {
+    }
+
+    [[nodiscard]] auto port() const -> std::string { return std::to_string( m_acceptor.local_endpoint().port() ); }
+
+  private:
+    asio::io_service m_service;
+    tcp::acceptor m_acceptor;
+    std::jthread m_thread;
+};
+
+auto
+make_block( std::size_t size ) -> std::vector<char>
+{
+    auto block = std::vector<char>( size );
+    std::generate( block.begin(), block.end(), [ i = 0u ]() mutable { return static_cast<char>( i++ * 31u ); } );
+    return block;
+}
+
+TEST( dslib, transport_names ) // [NOLINT]
+{
+    for ( auto kind : transports )
+    {
+        EXPECT_EQ( ds::to_transport( to_string( kind ) ), kind );
+    }
+
+    EXPECT_THROW( static_cast<void>( ds::to_transport( "serial" ) ), std::out_of_range );
+}
+
+TEST( dslib, transport_block_read ) // [NOLINT]
+{
+    const auto block = make_block( 4 * 1024 * 1024 );
+    const auto header = fmt::format( "#9{:09}", block.size() );
+
+    for ( auto kind : transports )
+    {
+        auto server = loopback_server{ header + std::string( block.begin(), block.end() ) + "\n" };
+        auto device = ds::make_lan_device( kind, "127.0.0.1", server.port() );
+
+        EXPECT_EQ( device->read_n( ds::as_string, header.size(), ds::idevice::default_timeout ), header )
+            << to_string( kind );
+
+        auto received = std::vector<char>( block.size() );
+        device->read_into( received, ds::idevice::default_timeout );
+        EXPECT_EQ( received, block ) << to_string( kind );
+
+        EXPECT_EQ( device->read_until( ds::as_string, ds::idevice::default_timeout, "\n" ), "\n" )
+            << to_string( kind );
+    }
+}
+
+TEST( dslib, transport_timeout ) // [NOLINT]
+{
+    for ( auto kind : transports )
+    {
+        auto server = loopback_server{ "" };
+        auto device = ds::make_lan_device( kind, "127.0.0.1", server.port() );
+
+        EXPECT_THROW( static_cast<void>( device->read_n( ds::as_vector, 1, 50ms ) ), std::runtime_error )
+            << to_string( kind );
+    }
+}
+
+TEST( dslib, transport_timeout_is_a_deadline ) // [NOLINT]
+{
+    // A byte that arrives halfway through must not restart the clock for the rest of the read
+    for ( auto kind : transports )
+    {
+        auto server = loopback_server{ "R", 150ms };
+        auto device = ds::make_lan_device( kind, "127.0.0.1", server.port() );
+
+        const auto start = std::chrono::steady_clock::now();
+        EXPECT_THROW( static_cast<void>( device->read_until( ds::as_string, 200ms, "\n" ) ), std::runtime_error )
+            << to_string( kind );
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_GE( elapsed, 200ms ) << to_string( kind );
+        EXPECT_LT( elapsed, 300ms ) << to_string( kind );
+    }
+}
+
+TEST( dslib, transport_read_block ) // [NOLINT]
+{
+    const auto block = make_block( 250'000 );
+
+    for ( auto kind : transports )
+    {
+        const auto header = fmt::format( "#9{:09}", block.size() );
+        auto server = loopback_server{ header + std::string( block.begin(), block.end() ) +
+                                       "\n#800000003abc\n#15hello\n#13abcX" };
+        auto device = ds::make_lan_device( kind, "127.0.0.1", server.port() );
+
+        auto received = std::vector<char>( block.size() );
+        EXPECT_EQ( device->read_block( received ), block.size() ) << to_string( kind );
+        EXPECT_EQ( received, block ) << to_string( kind );
+
+        auto small = std::vector<char>( 5 );
+        EXPECT_THROW( static_cast<void>( device->read_block( std::span{ small }.first( 2 ) ) ), std::length_error )
+            << to_string( kind );
+
+        // The oversized block has been drained, the next one parses from its header
+        EXPECT_EQ( device->read_block( small ), 5u ) << to_string( kind );
+        EXPECT_EQ( std::string_view( small.data(), small.size() ), "hello" ) << to_string( kind );
+
+        EXPECT_THROW( static_cast<void>( device->read_block( small ) ), std::runtime_error ) << to_string( kind );
+    }
+}
+
+TEST( dslib, socket_device_keeps_data_past_delimiter ) // [NOLINT]
+{
+    auto server = loopback_server{ "1\n0\nRIGOL" };
+    auto device = ds::socket_device{ "127.0.0.1", server.port() };
+
+    EXPECT_EQ( device.read_until( ds::as_string, ds::idevice::default_timeout, "\n" ), "1\n" );
+    EXPECT_EQ( device.read_until( ds::as_string, ds::idevice::default_timeout, "\n" ), "0\n" );
+    EXPECT_EQ( device.read_n( ds::as_string, 5 ), "RIGOL" );
+}
+
+TEST( dslib, socket_device_keeps_data_after_timeout ) // [NOLINT]
+{
+    auto server = loopback_server{ "RIGOL" };
+    auto device = ds::socket_device{ "127.0.0.1", server.port() };
+
+    EXPECT_THROW( static_cast<void>( device.read_until( ds::as_string, 50ms, "\n" ) ), std::runtime_error );
+    EXPECT_EQ( device.read_n( ds::as_string, 5 ), "RIGOL" );
+}
+
+} // namespace
@@ -0,0 +1,53 @@
+#include "dsview/dslib/device.hpp"
+#include "dsview/dslib/scpi/commands/all.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+
+namespace trigger = ds::scpi::trigger;
+namespace waveform = ds::scpi::waveform;
+
+TEST( dslib, trigger_status_response ) // [NOLINT]
+{
+    using parser = trigger::status_cmd::query_parser;
+
+    for ( auto status : { trigger::trigger_status::e_td,
+                          trigger::trigger_status::e_wait,
+                          trigger::trigger_status::e_run,
+                          trigger::trigger_status::e_auto,
+                          trigger::trigger_status::e_stop } )
+    {
+        EXPECT_EQ( parser::parse( fmt::format( "{}\n", to_string( status ) ) ), status );
+    }
+
+    EXPECT_ANY_THROW( static_cast<void>( parser::parse( "TRIGGERED\n" ) ) );
+    EXPECT_THROW( static_cast<void>( to_string( trigger::trigger_status{ 42 } ) ), std::out_of_range );
+}
+
+TEST( dslib, memory_depth_response ) // [NOLINT]
+{
+    using parser = waveform::memory_depth_cmd::query_parser;
+
+    EXPECT_EQ( parser::parse( "AUTO\n" ), std::nullopt );
+    EXPECT_EQ( parser::parse( "12000\n" ), 12000u );
+    EXPECT_EQ( parser::parse( "2.4E+07\n" ), 24'000'000u );
+}
+
+TEST( dslib, waveform_command_strings ) // [NOLINT]
+{
+    EXPECT_EQ( std::string_view{ waveform::data_cmd::get_query_string() }, ":WAV:DATA?" );
+    EXPECT_EQ( std::string_view{ trigger::status_cmd::get_query_string() }, ":TRIG:STAT?" );
+    EXPECT_EQ( waveform::source_cmd::get_command_string( std::string_view{ "CHAN2" } ), ":WAV:SOUR CHAN2" );
+    EXPECT_EQ( waveform::start_cmd::get_command_string( std::size_t{ 250001 } ), ":WAV:STAR 250001" );
+}
+
+static_assert( ds::binary_block_command<waveform::data_cmd> );
+static_assert( !ds::binary_block_command<waveform::memory_depth_cmd> );
+static_assert( !ds::binary_block_command<trigger::status_cmd> );
+
+} // namespace